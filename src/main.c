@@ -8,9 +8,15 @@
 #include "box2d/id.h"
 #include "box2d/collision.h"
 #include "box2d/types.h"
+#include "constants.h"
 #include <sys/time.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "Timing.h"
 
 #define RED_TRANSLUCENT (Color){0xFF, 0x00, 0x00, 0x40}
@@ -50,16 +56,24 @@
 #define recordTime(t) gettimeofday(&t, NULL);
 
 #define AUTOPAUSE 1
+#define SPAWN_STEPS 350
+
+// start from a settled world (cached in StartupCache) instead of watching it build
+#define PREWARM_WORLD 1
+#define PREWARM_STEPS 600 // SPAWN_STEPS plus time for the pile to settle
+
+#define CAMERA_PAN_SPEED 40.0f // m/s
 
 Timespan GetTimespan(wc_timeval before, wc_timeval after) {
-	time_t s_diff = labs(after.tv_sec - before.tv_sec);
-	suseconds_t us_diff = abs(after.tv_usec - before.tv_usec);
+	// borrow across the second boundary, otherwise 1.9s -> 2.1s reads as 1.8s
+	long long us_diff = llabs((after.tv_sec - before.tv_sec) * 1000000LL + (after.tv_usec - before.tv_usec));
+	time_t s_diff = us_diff / (MSECS_PER_SEC * USECS_PER_MSEC);
 	//printf("BEFORE: us=%07d s=%ld\n AFTER: us=%07d s=%ld\n", before.tv_usec, before.tv_sec, after.tv_usec, after.tv_sec);
 	return (Timespan) {
-		.m = ((time_t) s_diff) / SECS_PER_MIN,
-		.s = ((time_t) s_diff) % SECS_PER_MIN,
-		.ms = ((time_t) us_diff) / USECS_PER_MSEC,
-		.us = ((time_t) us_diff) % USECS_PER_MSEC,
+		.m = s_diff / SECS_PER_MIN,
+		.s = s_diff % SECS_PER_MIN,
+		.ms = (time_t) (us_diff / USECS_PER_MSEC) % MSECS_PER_SEC,
+		.us = (time_t) (us_diff % USECS_PER_MSEC),
 	};
 }
 
@@ -76,6 +90,7 @@ void PrintTimespan(Timespan t) {
 	printf("%02ld m %02ld s %03ld ms %03ld µs\n", t.m, t.s, t.ms, t.us);
 }
 bool SimulationPaused = AUTOPAUSE;
+bool Prewarming = false; // steps run back to back, so skip the wall clock spawn cooldown
 
 typedef struct timeval timeval;
 timeval t_LastSpawn, t_SpawnAttempt;
@@ -112,6 +127,8 @@ int subStepCount = 2;
 
 Font debugFont;
 Vector2 windowSize;
+b2Vec2 ViewOrigin = {0.0f, 0.0f};   // world pos of the bottom left of the screen
+b2Vec2 ViewVelocity = {0.0f, 0.0f}; // m/s, used to prefetch chunks ahead of the camera
 
 typedef struct box {
 	b2BodyId id;
@@ -130,23 +147,23 @@ typedef struct revJoint {
 
 Vector2 worldToScreen(b2Vec2 worldPos) {
 	Vector2 screenPos;
-	screenPos.x = worldPos.x * PPM;
-	screenPos.y = windowSize.y - (worldPos.y * PPM);
+	screenPos.x = (worldPos.x - ViewOrigin.x) * PPM;
+	screenPos.y = windowSize.y - ((worldPos.y - ViewOrigin.y) * PPM);
 	return screenPos;
 }
 
 b2Vec2 screenToWorld(float sx, float sy) {
 	b2Vec2 worldPos = {
-		worldPos.x = sx / PPM,
-		worldPos.y = (windowSize.y - sy) / PPM,
+		worldPos.x = ViewOrigin.x + sx / PPM,
+		worldPos.y = ViewOrigin.y + (windowSize.y - sy) / PPM,
 	};
 	return worldPos;
 }
 
 b2Vec2 screenToWorldV(Vector2 s) {
 	b2Vec2 worldPos = {
-		worldPos.x = s.x / PPM,
-		worldPos.y = (windowSize.y - s.y) / PPM,
+		worldPos.x = ViewOrigin.x + s.x / PPM,
+		worldPos.y = ViewOrigin.y + (windowSize.y - s.y) / PPM,
 	};
 	return worldPos;
 }
@@ -329,7 +346,7 @@ void AttemptSpawnBox(b2Vec2 worldPos) {
 	const int spawnperclick = 2;
 	recordTime(t_SpawnAttempt);
 	if (BoxCount < MAX_BOXES) {
-		bool cooldownElapsed = timeDiff(t_LastSpawn, t_SpawnAttempt) > SPAWN_COOLDOWN_MS;
+		bool cooldownElapsed = Prewarming || timeDiff(t_LastSpawn, t_SpawnAttempt) > SPAWN_COOLDOWN_MS;
 		if (cooldownElapsed) {
 			for (int i = 0; i < spawnperclick; i++) {
 				Boxes[BoxCount] = CreateBox(worldPos, SPAWNABLE_BOX_SIZE, SPAWNABLE_BOX_DENSITY, BOX_FRICTION, IS_DYNAMIC);
@@ -378,11 +395,1103 @@ b2JointId WeldBodies(b2BodyId id_a, b2BodyId id_b, b2Vec2 pivot) {
 	};
 	return jointId;
 }
+// WorldChunks.c
+// the world is cut into CHUNK_SIZE square chunks. chunks near the view or near
+// an awake body are live in the b2 world, everything else is packed down to a
+// PackedBox array and its bodies destroyed. sleeping bodies stay asleep when
+// they come back. a worker thread generates/unpacks the chunks the camera is
+// heading towards so they're ready before they're needed.
+// the hand built layout (LayoutBoxes, Balls, Joints) is never streamed.
+
+#define CHUNK_SIZE 32.0f
+#define MAX_CHUNKS 4096           // must be a power of 2, linear probing
+#define CHUNK_VIEW_MARGIN 1       // chunks kept live around the screen
+#define CHUNK_PREFETCH_SECS 0.75f // how far ahead of the camera to prefetch
+#define CHUNK_UPDATE_RATE 4       // frames between streaming passes
+#define CHUNK_BODY_REACH 2.0f     // how close an awake body gets to an edge before the next chunk loads
+#define CHUNK_JOB_QUEUE 64
+#define MAX_CHUNK_GEN_BOXES 32
+
+#define CHUNK_FLOOR_Y 2.0f        // matches the layout floor
+#define CHUNK_FLOOR_THICK 0.5f
+
+// packed fixed point scales. 1/2048m is well under b2_linearSlop so a settled
+// pile doesn't pop when it comes back
+#define CHUNK_POS_SCALE (65535.0f / CHUNK_SIZE)
+#define CHUNK_EXTENT_SCALE 1024.0f
+#define CHUNK_ANGLE_SCALE (32767.0f / B2_PI)
+#define CHUNK_DENSITY_SCALE 16.0f  // up to ~15.9, saturates past that
+#define CHUNK_FRICTION_SCALE 100.0f // up to 2.55
+#define PACKED_DYNAMIC 0x1
+
+typedef enum chunkState {
+	CHUNK_FREE = 0,  // unused table slot
+	CHUNK_UNVISITED, // never instantiated, contents come from GenerateChunk
+	CHUNK_PENDING,   // queued on/being built by the worker
+	CHUNK_READY,     // records built, waiting to be instantiated
+	CHUNK_LIVE,
+	CHUNK_FROZEN,
+} ChunkState;
+
+typedef struct packedBox {
+	uint16_t x, y;   // offset from the chunk origin
+	int16_t angle;
+	uint16_t hx, hy;
+	uint8_t density;
+	uint8_t friction;
+	uint8_t flags;
+} PackedBox;
+
+typedef struct boxRecord {
+	b2Vec2 pos;
+	float angle;
+	b2Vec2 hExtent;
+	float density;
+	float friction;
+	bool isDynamic;
+	bool isAwake;
+} BoxRecord;
+
+typedef struct chunk {
+	int cx, cy;
+	ChunkState state;
+	bool visited;  // has been live at least once, so packed is authoritative
+	bool wanted;
+	bool prefetch;
+	bool freezing;
+	PackedBox *packed;
+	int packedCount;
+	int packedCap;
+	BoxRecord *records;
+	int recordCount;
+} Chunk;
+
+Chunk Chunks[MAX_CHUNKS];
+int LiveChunkCount = 0;
+int FrozenChunkCount = 0;
+float HomeMinX, HomeMaxX; // x extent of the layout floor
+
+pthread_t ChunkWorker;
+pthread_mutex_t ChunkLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t ChunkJobCond = PTHREAD_COND_INITIALIZER;
+pthread_cond_t ChunkDoneCond = PTHREAD_COND_INITIALIZER;
+// jobs and the worker go by coords, entries can move when one is removed
+typedef struct chunkJob {
+	int cx, cy;
+} ChunkJob;
+
+ChunkJob ChunkJobs[CHUNK_JOB_QUEUE];
+int ChunkJobHead = 0;
+int ChunkJobCount = 0;
+bool ChunkWorkerBusy = false;
+ChunkJob ChunkWorkerJob; // chunk the worker is building while busy
+bool ChunkWorkerQuit = false;
+bool ChunkTableFullWarned = false;
+int BoxChunk[MAX_BOXES]; // FreezeChunks scratch, chunk slot of each box
+int PinnedBodyTag;       // userData of layout bodies, they never stream
+
+int ChunkCoord(float v) {
+	return (int)floorf(v / CHUNK_SIZE);
+}
+
+uint32_t ChunkSeed(int cx, int cy) {
+	uint32_t h = ((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u);
+	return h ? h : 1u;
+}
+
+int FindChunk(int cx, int cy, bool insert) {
+	uint32_t h = ChunkSeed(cx, cy);
+	for (int i = 0; i < MAX_CHUNKS; i++) {
+		int idx = (h + i) & (MAX_CHUNKS - 1);
+		Chunk *c = &Chunks[idx];
+		if (c->state == CHUNK_FREE) {
+			if (!insert) return -1;
+			*c = (Chunk) {
+				.cx = cx, .cy = cy, .state = CHUNK_UNVISITED
+			};
+			return idx;
+		}
+		if (c->cx == cx && c->cy == cy) return idx;
+	}
+	if (insert && !ChunkTableFullWarned) {
+		printf("chunk table full (%d), chunk %d,%d left unmanaged\n", MAX_CHUNKS, cx, cy);
+		ChunkTableFullWarned = true;
+	}
+	return -1;
+}
+
+// backward shift delete, keeps every probe chain unbroken without tombstones
+void RemoveChunk(int idx) {
+	free(Chunks[idx].packed);
+	free(Chunks[idx].records);
+	Chunks[idx] = (Chunk) {0};
+
+	int hole = idx;
+	for (int j = (idx + 1) & (MAX_CHUNKS - 1); Chunks[j].state != CHUNK_FREE; j = (j + 1) & (MAX_CHUNKS - 1)) {
+		int home = ChunkSeed(Chunks[j].cx, Chunks[j].cy) & (MAX_CHUNKS - 1);
+		// leave it if its home slot is cyclically in (hole, j]
+		bool reachable = hole <= j ? (home > hole && home <= j) : (home > hole || home <= j);
+		if (reachable) continue;
+		Chunks[hole] = Chunks[j];
+		Chunks[j] = (Chunk) {0};
+		hole = j;
+	}
+	ChunkTableFullWarned = false;
+}
+
+// whether GenerateChunk puts anything in this chunk
+bool ChunkGenerates(int cx, int cy) {
+	(void)cx;
+	return cy == 0; // only the ground row has anything in it for now
+}
+
+// xorshift, the worker can't touch rand()
+uint32_t ChunkRand(uint32_t *s) {
+	*s ^= *s << 13;
+	*s ^= *s >> 17;
+	*s ^= *s << 5;
+	return *s;
+}
+
+float ChunkRandf(uint32_t *s, float min, float max) {
+	return min + ((float)ChunkRand(s) / (float)UINT32_MAX) * (max - min);
+}
+
+int GenerateChunk(int cx, int cy, BoxRecord *out) {
+	if (!ChunkGenerates(cx, cy)) return 0;
+
+	int n = 0;
+	float x0 = cx * CHUNK_SIZE;
+	float x1 = x0 + CHUNK_SIZE;
+	bool overlapsHome = x0 < HomeMaxX && x1 > HomeMinX;
+
+	// floor, clipped so it doesn't double up with the layout floor
+	float fx0 = x0, fx1 = x1;
+	if (overlapsHome) {
+		if (fx0 < HomeMinX) fx1 = HomeMinX;
+		else if (fx1 > HomeMaxX) fx0 = HomeMaxX;
+		else fx1 = fx0;
+	}
+	if (fx1 > fx0) {
+		out[n++] = (BoxRecord) {
+			.pos = {(fx0 + fx1) / 2.0f, CHUNK_FLOOR_Y},
+			.hExtent = {(fx1 - fx0) / 2.0f, CHUNK_FLOOR_THICK / 2.0f},
+			.density = LAYOUT_BOX_DENSITY, .friction = LAYOUT_BOX_FRICTION,
+		};
+	}
+	if (overlapsHome) return n;
+
+	// a couple of pillars with a stack of boxes on each
+	uint32_t seed = ChunkSeed(cx, cy);
+	float floorTop = CHUNK_FLOOR_Y + CHUNK_FLOOR_THICK / 2.0f;
+	int pillars = 1 + ChunkRand(&seed) % 2;
+	for (int i = 0; i < pillars; i++) {
+		float x = ChunkRandf(&seed, x0 + 2.0f, x1 - 2.0f);
+		float h = ChunkRandf(&seed, 1.0f, 6.0f);
+		out[n++] = (BoxRecord) {
+			.pos = {x, floorTop + h / 2.0f},
+			.hExtent = {0.5f, h / 2.0f},
+			.density = LAYOUT_BOX_DENSITY, .friction = LAYOUT_BOX_FRICTION,
+		};
+
+		int stack = 2 + ChunkRand(&seed) % 6;
+		float boxH = SPAWNABLE_BOX_SIZE.height;
+		for (int j = 0; j < stack; j++) {
+			out[n++] = (BoxRecord) {
+				.pos = {x, floorTop + h + boxH * (j + 0.5f)},
+				.hExtent = {SPAWNABLE_BOX_SIZE.width / 2.0f, boxH / 2.0f},
+				.density = SPAWNABLE_BOX_DENSITY, .friction = BOX_FRICTION,
+				.isDynamic = true, .isAwake = false, // placed at rest
+			};
+		}
+	}
+	assert(n <= MAX_CHUNK_GEN_BOXES);
+	return n;
+}
+
+uint16_t PackUnsigned(float v, float scale) {
+	float q = roundf(v * scale);
+	return (uint16_t)(q < 0.0f ? 0.0f : (q > 65535.0f ? 65535.0f : q));
+}
+
+uint8_t PackByte(float v, float scale) {
+	float q = roundf(v * scale);
+	return (uint8_t)(q < 0.0f ? 0.0f : (q > 255.0f ? 255.0f : q));
+}
+
+void PackBox(Chunk *c, Box box) {
+	if (c->packedCount == c->packedCap) {
+		c->packedCap = c->packedCap ? c->packedCap * 2 : 64;
+		c->packed = realloc(c->packed, c->packedCap * sizeof(PackedBox));
+	}
+	b2ShapeId shapeId;
+	b2Body_GetShapes(box.id, &shapeId, 1);
+	b2Transform tr = b2Body_GetTransform(box.id);
+	b2Vec2 origin = {c->cx * CHUNK_SIZE, c->cy * CHUNK_SIZE};
+
+	c->packed[c->packedCount++] = (PackedBox) {
+		.x = PackUnsigned(tr.p.x - origin.x, CHUNK_POS_SCALE),
+		.y = PackUnsigned(tr.p.y - origin.y, CHUNK_POS_SCALE),
+		.angle = (int16_t)roundf(b2Rot_GetAngle(tr.q) * CHUNK_ANGLE_SCALE),
+		.hx = PackUnsigned(box.hExtent.x, CHUNK_EXTENT_SCALE),
+		.hy = PackUnsigned(box.hExtent.y, CHUNK_EXTENT_SCALE),
+		.density = PackByte(b2Shape_GetDensity(shapeId), CHUNK_DENSITY_SCALE),
+		.friction = PackByte(b2Shape_GetFriction(shapeId), CHUNK_FRICTION_SCALE),
+		.flags = b2Body_GetType(box.id) == b2_dynamicBody ? PACKED_DYNAMIC : 0,
+	};
+}
+
+BoxRecord UnpackBox(PackedBox p, b2Vec2 origin) {
+	return (BoxRecord) {
+		.pos = {origin.x + p.x / CHUNK_POS_SCALE, origin.y + p.y / CHUNK_POS_SCALE},
+		.angle = p.angle / CHUNK_ANGLE_SCALE,
+		.hExtent = {p.hx / CHUNK_EXTENT_SCALE, p.hy / CHUNK_EXTENT_SCALE},
+		.density = p.density / CHUNK_DENSITY_SCALE,
+		.friction = p.friction / CHUNK_FRICTION_SCALE,
+		.isDynamic = p.flags & PACKED_DYNAMIC,
+		.isAwake = false,
+	};
+}
+
+// safe to call off the main thread, doesn't touch the b2 world
+BoxRecord *BuildChunkRecords(int cx, int cy, bool visited, const PackedBox *packed, int packedCount, int *outCount) {
+	if (!visited) {
+		BoxRecord *records = malloc(MAX_CHUNK_GEN_BOXES * sizeof(BoxRecord));
+		*outCount = GenerateChunk(cx, cy, records);
+		return records;
+	}
+	b2Vec2 origin = {cx * CHUNK_SIZE, cy * CHUNK_SIZE};
+	BoxRecord *records = malloc((packedCount ? packedCount : 1) * sizeof(BoxRecord));
+	for (int i = 0; i < packedCount; i++) records[i] = UnpackBox(packed[i], origin);
+	*outCount = packedCount;
+	return records;
+}
+
+void *ChunkWorkerMain(void *arg) {
+	(void)arg;
+	pthread_mutex_lock(&ChunkLock);
+	while (!ChunkWorkerQuit) {
+		if (ChunkJobCount == 0) {
+			pthread_cond_wait(&ChunkJobCond, &ChunkLock);
+			continue;
+		}
+		ChunkJob job = ChunkJobs[ChunkJobHead];
+		ChunkJobHead = (ChunkJobHead + 1) % CHUNK_JOB_QUEUE;
+		ChunkJobCount--;
+
+		int idx = FindChunk(job.cx, job.cy, false);
+		if (idx < 0 || Chunks[idx].state != CHUNK_PENDING) continue; // main thread got to it first
+		ChunkWorkerBusy = true;
+		ChunkWorkerJob = job;
+		int packedCount = Chunks[idx].packedCount;
+		bool visited = Chunks[idx].visited;
+		const PackedBox *packed = Chunks[idx].packed; // not freed while PENDING
+		pthread_mutex_unlock(&ChunkLock);
+
+		int recordCount;
+		BoxRecord *records = BuildChunkRecords(job.cx, job.cy, visited, packed, packedCount, &recordCount);
+
+		pthread_mutex_lock(&ChunkLock);
+		idx = FindChunk(job.cx, job.cy, false); // may have shifted while unlocked
+		if (idx >= 0 && Chunks[idx].state == CHUNK_PENDING) {
+			Chunks[idx].records = records;
+			Chunks[idx].recordCount = recordCount;
+			Chunks[idx].state = CHUNK_READY;
+		} else {
+			free(records);
+		}
+		ChunkWorkerBusy = false;
+		pthread_cond_broadcast(&ChunkDoneCond);
+	}
+	pthread_mutex_unlock(&ChunkLock);
+	return NULL;
+}
+
+void StartChunkWorker() {
+	ChunkWorkerQuit = false;
+	pthread_create(&ChunkWorker, NULL, ChunkWorkerMain, NULL);
+}
+
+void StopChunkWorker() {
+	pthread_mutex_lock(&ChunkLock);
+	ChunkWorkerQuit = true;
+	pthread_cond_signal(&ChunkJobCond);
+	pthread_mutex_unlock(&ChunkLock);
+	pthread_join(ChunkWorker, NULL);
+}
+
+// bodies are owned by the world, so this only drops the chunk data. call
+// before b2DestroyWorld.
+void ResetChunks() {
+	pthread_mutex_lock(&ChunkLock);
+	ChunkJobCount = 0;
+	while (ChunkWorkerBusy) pthread_cond_wait(&ChunkDoneCond, &ChunkLock);
+	for (int i = 0; i < MAX_CHUNKS; i++) {
+		free(Chunks[i].packed);
+		free(Chunks[i].records);
+		Chunks[i] = (Chunk) {0};
+	}
+	LiveChunkCount = 0;
+	FrozenChunkCount = 0;
+	ChunkTableFullWarned = false;
+	pthread_mutex_unlock(&ChunkLock);
+}
+
+void SetupChunks(b2Vec2 worldSize) {
+	// the layout floor is 2*worldSize.x wide, centered on worldSize.x/2
+	HomeMinX = -worldSize.x / 2.0f;
+	HomeMaxX = worldSize.x * 1.5f;
+}
+
+// everything below runs on the main thread with ChunkLock held
+
+void QueueChunkJob(int idx) {
+	if (ChunkJobCount == CHUNK_JOB_QUEUE) return; // try again next pass
+	Chunks[idx].state = CHUNK_PENDING;
+	ChunkJobs[(ChunkJobHead + ChunkJobCount) % CHUNK_JOB_QUEUE] = (ChunkJob) {
+		Chunks[idx].cx, Chunks[idx].cy
+	};
+	ChunkJobCount++;
+	pthread_cond_signal(&ChunkJobCond);
+}
+
+// drop a prefetched chunk that we ended up not needing
+void EvictChunk(Chunk *c) {
+	free(c->records);
+	c->records = NULL;
+	c->recordCount = 0;
+	c->state = c->visited ? CHUNK_FROZEN : CHUNK_UNVISITED;
+}
+
+Box CreateBoxFromRecord(BoxRecord r) {
+	b2BodyDef bodyDef = b2DefaultBodyDef();
+	bodyDef.type = r.isDynamic ? b2_dynamicBody : b2_staticBody;
+	bodyDef.position = r.pos;
+	bodyDef.rotation = b2MakeRot(r.angle);
+	bodyDef.isAwake = r.isAwake;
+	b2BodyId bodyId = b2CreateBody(worldId, &bodyDef);
+
+	b2Polygon poly = b2MakeBox(r.hExtent.x, r.hExtent.y);
+	b2ShapeDef shapeDef = b2DefaultShapeDef();
+	shapeDef.density = r.density;
+	shapeDef.material.friction = r.friction;
+	b2CreatePolygonShape(bodyId, &shapeDef, &poly);
+	return (Box) {
+		.id = bodyId, .hExtent = r.hExtent
+	};
+}
+
+void LoadChunk(int idx) {
+	Chunk *c = &Chunks[idx];
+	if (c->state == CHUNK_PENDING) {
+		if (ChunkWorkerBusy && ChunkWorkerJob.cx == c->cx && ChunkWorkerJob.cy == c->cy) {
+			// the worker only writes back, it doesn't move entries, so c stays put
+			while (c->state == CHUNK_PENDING) pthread_cond_wait(&ChunkDoneCond, &ChunkLock);
+		} else {
+			// still queued, quicker to just build it here. the worker skips it.
+			c->state = c->visited ? CHUNK_FROZEN : CHUNK_UNVISITED;
+		}
+	}
+	if (c->state != CHUNK_READY) {
+		c->records = BuildChunkRecords(c->cx, c->cy, c->visited, c->packed, c->packedCount, &c->recordCount);
+		c->state = CHUNK_READY;
+		if (BoxCount + c->recordCount > MAX_BOXES)
+			printf("chunk %d,%d doesn't fit in Boxes (%d/%d), deferring\n", c->cx, c->cy, BoxCount, MAX_BOXES);
+	}
+	// all or nothing, a half loaded chunk would lose the rest of its boxes.
+	// it stays READY (packed data intact) and the next pass tries again.
+	if (BoxCount + c->recordCount > MAX_BOXES) return;
+
+	for (int i = 0; i < c->recordCount; i++)
+		Boxes[BoxCount++] = CreateBoxFromRecord(c->records[i]);
+
+	free(c->records);
+	free(c->packed);
+	c->records = NULL;
+	c->recordCount = 0;
+	c->packed = NULL;
+	c->packedCount = 0;
+	c->packedCap = 0;
+	c->visited = true;
+	c->state = CHUNK_LIVE;
+}
+
+typedef struct freezeQuery {
+	b2BodyId self;
+	b2AABB bounds;
+	bool leftLive;
+} FreezeQuery;
+
+bool FreezeQueryFcn(b2ShapeId shapeId, void *context) {
+	FreezeQuery *q = context;
+	b2BodyId other = b2Shape_GetBody(shapeId);
+	if (B2_ID_EQUALS(other, q->self)) return true;
+	if (b2Body_GetType(other) == b2_staticBody) return true; // never woken
+	// the tree hands back fat AABBs, check the tight one
+	if (!b2AABB_Overlaps(b2Shape_GetAABB(shapeId), q->bounds)) return true;
+
+	b2Vec2 p = b2Body_GetPosition(other);
+	int idx = FindChunk(ChunkCoord(p.x), ChunkCoord(p.y), false);
+	if (b2Body_GetUserData(other) == &PinnedBodyTag || idx < 0 || !Chunks[idx].freezing) {
+		q->leftLive = true;
+		return false;
+	}
+	return true;
+}
+
+// true if the box touches a dynamic body that won't be frozen with it.
+// destroying the box would wake that body and drop whatever it rests on.
+// goes by geometry, not contacts: bodies created asleep (LoadChunk, generated
+// stacks, LoadWorldSnapshot) have no touching contacts until they wake.
+bool TouchesBodyLeftLive(b2BodyId id) {
+	b2ShapeId shapeId;
+	b2Body_GetShapes(id, &shapeId, 1);
+	b2AABB aabb = b2Shape_GetAABB(shapeId);
+	b2Vec2 slop = {B2_LINEAR_SLOP, B2_LINEAR_SLOP};
+	aabb.lowerBound = b2Sub(aabb.lowerBound, slop);
+	aabb.upperBound = b2Add(aabb.upperBound, slop);
+
+	FreezeQuery q = {
+		.self = id, .bounds = aabb, .leftLive = false
+	};
+	b2World_OverlapAABB(worldId, aabb, b2DefaultQueryFilter(), FreezeQueryFcn, &q);
+	return q.leftLive;
+}
+
+void FreezeChunks() {
+	for (int i = 0; i < BoxCount; i++) {
+		b2Vec2 p = b2Body_GetPosition(Boxes[i].id);
+		BoxChunk[i] = FindChunk(ChunkCoord(p.x), ChunkCoord(p.y), false);
+	}
+
+	// boxes belong to the chunk under their center, so a pile resting across
+	// an edge would get cut in half. keep any freezing chunk that touches
+	// something staying live, until no more change. a pile only freezes once
+	// every chunk it spans is leaving.
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int i = 0; i < BoxCount; i++) {
+			int idx = BoxChunk[i];
+			if (idx < 0 || !Chunks[idx].freezing) continue;
+			if (TouchesBodyLeftLive(Boxes[i].id)) {
+				Chunks[idx].freezing = false;
+				changed = true;
+			}
+		}
+	}
+
+	int i = 0;
+	while (i < BoxCount) {
+		int idx = BoxChunk[i];
+		if (idx < 0 || !Chunks[idx].freezing) {
+			i++;
+			continue;
+		}
+		PackBox(&Chunks[idx], Boxes[i]);
+		b2DestroyBody(Boxes[i].id);
+		BoxCount--;
+		Boxes[i] = Boxes[BoxCount];
+		BoxChunk[i] = BoxChunk[BoxCount];
+	}
+	for (int j = 0; j < MAX_CHUNKS; j++) {
+		if (!Chunks[j].freezing) continue;
+		Chunks[j].freezing = false;
+		Chunks[j].state = CHUNK_FROZEN;
+	}
+}
+
+void MarkChunkRect(int x0, int y0, int x1, int y1, bool prefetch) {
+	for (int cy = y0; cy <= y1; cy++) {
+		for (int cx = x0; cx <= x1; cx++) {
+			// nothing to prefetch in a chunk that would generate empty
+			bool insert = !prefetch || ChunkGenerates(cx, cy);
+			int idx = FindChunk(cx, cy, insert);
+			if (idx < 0) continue;
+			if (prefetch) Chunks[idx].prefetch = true;
+			else Chunks[idx].wanted = true;
+		}
+	}
+}
+
+void MarkViewChunks(b2Vec2 offset, int margin, bool prefetch) {
+	b2Vec2 lo = b2Add(ViewOrigin, offset);
+	b2Vec2 hi = b2Add(lo, (b2Vec2) {
+		windowSize.x / PPM, windowSize.y / PPM
+	});
+	MarkChunkRect(ChunkCoord(lo.x) - margin, ChunkCoord(lo.y) - margin,
+	              ChunkCoord(hi.x) + margin, ChunkCoord(hi.y) + margin, prefetch);
+}
+
+// keeps the chunk under an awake body live, plus any neighbour it is close to
+// or about to move into
+void MarkAwakeBody(b2BodyId id) {
+	if (b2Body_GetType(id) == b2_staticBody || !b2Body_IsAwake(id)) return;
+	b2Vec2 p = b2Body_GetPosition(id);
+	b2Vec2 ahead = b2MulAdd(p, CHUNK_PREFETCH_SECS, b2Body_GetLinearVelocity(id));
+	b2Vec2 lo = b2Min(p, ahead), hi = b2Max(p, ahead);
+	MarkChunkRect(ChunkCoord(lo.x - CHUNK_BODY_REACH), ChunkCoord(lo.y - CHUNK_BODY_REACH),
+	              ChunkCoord(hi.x + CHUNK_BODY_REACH), ChunkCoord(hi.y + CHUNK_BODY_REACH), false);
+}
+
+void UpdateChunkStreaming() {
+	pthread_mutex_lock(&ChunkLock);
+	for (int i = 0; i < MAX_CHUNKS; i++) {
+		Chunks[i].wanted = false;
+		Chunks[i].prefetch = false;
+	}
+
+	MarkViewChunks(b2Vec2_zero, CHUNK_VIEW_MARGIN, false);
+	for (int i = 0; i < BoxCount; i++) MarkAwakeBody(Boxes[i].id);
+	for (int i = 0; i < LayoutBoxCount; i++) MarkAwakeBody(LayoutBoxes[i].id);
+	for (int i = 0; i < BALL_COUNT; i++) MarkAwakeBody(Balls[i].id);
+
+	b2Vec2 ahead = b2MulSV(CHUNK_PREFETCH_SECS, ViewVelocity);
+	if (b2LengthSquared(ahead) > 0.0f) MarkViewChunks(ahead, CHUNK_VIEW_MARGIN + 1, true);
+
+	bool anyFreezing = false;
+	for (int i = 0; i < MAX_CHUNKS; i++) {
+		Chunk *c = &Chunks[i];
+		if (c->state == CHUNK_FREE) continue;
+
+		if (c->wanted) {
+			if (c->state != CHUNK_LIVE) LoadChunk(i);
+		} else if (c->prefetch) {
+			if (c->state == CHUNK_UNVISITED || c->state == CHUNK_FROZEN) QueueChunkJob(i);
+		} else if (c->state == CHUNK_LIVE) {
+			c->freezing = true;
+			anyFreezing = true;
+		} else if (c->state == CHUNK_READY) {
+			EvictChunk(c);
+		}
+	}
+	if (anyFreezing) FreezeChunks();
+
+	// forget chunks holding nothing GenerateChunk couldn't give back
+	LiveChunkCount = 0;
+	FrozenChunkCount = 0;
+	for (int i = 0; i < MAX_CHUNKS; i++) {
+		Chunk *c = &Chunks[i];
+		if (c->state == CHUNK_FREE) continue;
+		bool forgettable = c->state == CHUNK_UNVISITED ||
+		                   (c->state == CHUNK_FROZEN && c->packedCount == 0 && !ChunkGenerates(c->cx, c->cy));
+		if (forgettable && !c->wanted && !c->prefetch) {
+			RemoveChunk(i);
+			i--; // the next entry in the chain may have shifted into this slot
+			continue;
+		}
+		if (c->state == CHUNK_LIVE) LiveChunkCount++;
+		if (c->state == CHUNK_FROZEN) FrozenChunkCount++;
+	}
+	pthread_mutex_unlock(&ChunkLock);
+}
+
+// StartupCache.c
+// cold start shortcuts. the baked font atlas and a settled copy of the world
+// are kept in CACHE_DIR so a relaunch doesn't redo the work. both are plain
+// native endian dumps, they only need to be read back on the same machine.
+// each is keyed on what went into it (the exe's mod time covers code and
+// constants, plus the inputs we can compare directly) and is rebuilt on any
+// mismatch. STARTUP_CACHE_VERSION only covers the file layouts themselves.
+
+#define CACHE_DIR "cache"
+#define FONT_PATH "fonts/0xProtoNerdFont-Regular.ttf"
+#define FONT_CACHE_PATH CACHE_DIR "/font.bin"
+#define WORLD_CACHE_PATH CACHE_DIR "/world.bin"
+#define FONT_CACHE_MAGIC 0x46424452u  // "RDBF"
+#define WORLD_CACHE_MAGIC 0x57424452u // "RDBW"
+#define STARTUP_CACHE_VERSION 1
+
+// same as raylib's LoadFont() defaults for a ttf
+#define FONT_BAKE_SIZE 32
+#define FONT_BAKE_GLYPHS 95
+#define FONT_BAKE_PADDING 4
+
+typedef struct startupTimes {
+	wc_timeval launch;
+	Timespan window;
+	Timespan world;
+	Timespan fontBake;   // on the loader thread, overlaps window + world
+	Timespan fontUpload;
+	Timespan firstFrame; // since launch
+	const char *worldSource;
+	bool fontCached;
+	bool firstFrameDone;
+	bool printed;
+} StartupTimes;
+
+StartupTimes Startup;
+long ExeModTime = 0; // set from argv[0] in main(), 0 if it can't be found
+
+typedef struct cacheReader {
+	const unsigned char *data;
+	int size;
+	int at;
+} CacheReader;
+
+bool CacheRead(CacheReader *r, void *dst, int n) {
+	if (n < 0 || r->at + n > r->size) return false;
+	memcpy(dst, r->data + r->at, n);
+	r->at += n;
+	return true;
+}
+
+// ---- font ----
+
+typedef struct fontCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	long exeModTime;
+	long srcModTime;
+	int srcSize;
+	int baseSize;
+	int glyphCount;
+	int glyphPadding;
+	int atlasWidth;
+	int atlasHeight;
+	int atlasFormat;
+} FontCacheHeader;
+
+typedef struct glyphMetrics {
+	int value;
+	int offsetX;
+	int offsetY;
+	int advanceX;
+} GlyphMetrics;
+
+// cpu half of a font load, the atlas texture gets made on the main thread
+typedef struct fontBake {
+	Font font;
+	Image atlas;
+	bool fromCache;
+	Timespan time;
+	atomic_bool done;
+} FontBake;
+
+pthread_t FontLoader;
+FontBake PendingFont;
+bool DebugFontLoaded = false;
+
+// raylib keeps a per glyph image cut from the atlas around for ImageDrawText
+void CutGlyphImages(Font *font, Image atlas) {
+	for (int i = 0; i < font->glyphCount; i++) {
+		UnloadImage(font->glyphs[i].image);
+		font->glyphs[i].image = ImageFromImage(atlas, font->recs[i]);
+	}
+}
+
+bool LoadFontCache(FontBake *bake) {
+	if (!FileExists(FONT_CACHE_PATH)) return false;
+	int size;
+	unsigned char *data = LoadFileData(FONT_CACHE_PATH, &size);
+	if (data == NULL) return false;
+
+	CacheReader r = {data, size, 0};
+	FontCacheHeader h;
+	bool ok = CacheRead(&r, &h, sizeof(h)) &&
+	          h.magic == FONT_CACHE_MAGIC && h.version == STARTUP_CACHE_VERSION &&
+	          h.exeModTime == ExeModTime &&
+	          h.srcModTime == GetFileModTime(FONT_PATH) && h.srcSize == GetFileLength(FONT_PATH) &&
+	          h.baseSize == FONT_BAKE_SIZE && h.glyphCount == FONT_BAKE_GLYPHS &&
+	          h.glyphPadding == FONT_BAKE_PADDING;
+	int pixelBytes = ok ? GetPixelDataSize(h.atlasWidth, h.atlasHeight, h.atlasFormat) : 0;
+	ok = ok && size == (int)sizeof(h) + h.glyphCount * (int)(sizeof(GlyphMetrics) + sizeof(Rectangle)) + pixelBytes;
+	if (!ok) {
+		UnloadFileData(data);
+		return false;
+	}
+
+	Font font = {
+		.baseSize = h.baseSize, .glyphCount = h.glyphCount, .glyphPadding = h.glyphPadding,
+		.recs = RL_MALLOC(h.glyphCount * sizeof(Rectangle)),
+		.glyphs = RL_CALLOC(h.glyphCount, sizeof(GlyphInfo)),
+	};
+	for (int i = 0; i < h.glyphCount; i++) {
+		GlyphMetrics m;
+		CacheRead(&r, &m, sizeof(m));
+		font.glyphs[i] = (GlyphInfo) {
+			.value = m.value, .offsetX = m.offsetX, .offsetY = m.offsetY, .advanceX = m.advanceX
+		};
+	}
+	CacheRead(&r, font.recs, h.glyphCount * sizeof(Rectangle));
+
+	Image atlas = {
+		.data = RL_MALLOC(pixelBytes), .width = h.atlasWidth, .height = h.atlasHeight,
+		.mipmaps = 1, .format = h.atlasFormat,
+	};
+	CacheRead(&r, atlas.data, pixelBytes);
+	UnloadFileData(data);
+
+	CutGlyphImages(&font, atlas);
+	bake->font = font;
+	bake->atlas = atlas;
+	return true;
+}
+
+void SaveFontCache(const FontBake *bake) {
+	const Font *font = &bake->font;
+	FontCacheHeader h = {
+		.magic = FONT_CACHE_MAGIC, .version = STARTUP_CACHE_VERSION, .exeModTime = ExeModTime,
+		.srcModTime = GetFileModTime(FONT_PATH), .srcSize = GetFileLength(FONT_PATH),
+		.baseSize = font->baseSize, .glyphCount = font->glyphCount, .glyphPadding = font->glyphPadding,
+		.atlasWidth = bake->atlas.width, .atlasHeight = bake->atlas.height, .atlasFormat = bake->atlas.format,
+	};
+
+	MakeDirectory(CACHE_DIR);
+	FILE *f = fopen(FONT_CACHE_PATH, "wb");
+	if (f == NULL) return;
+	fwrite(&h, sizeof(h), 1, f);
+	for (int i = 0; i < font->glyphCount; i++) {
+		GlyphMetrics m = {
+			font->glyphs[i].value, font->glyphs[i].offsetX, font->glyphs[i].offsetY, font->glyphs[i].advanceX
+		};
+		fwrite(&m, sizeof(m), 1, f);
+	}
+	fwrite(font->recs, sizeof(Rectangle), font->glyphCount, f);
+	fwrite(bake->atlas.data, GetPixelDataSize(h.atlasWidth, h.atlasHeight, h.atlasFormat), 1, f);
+	fclose(f);
+}
+
+// what LoadFontEx() does, minus the texture upload
+bool BakeFont(FontBake *bake) {
+	int size;
+	unsigned char *data = LoadFileData(FONT_PATH, &size);
+	if (data == NULL) return false;
+
+	Font font = {
+		.baseSize = FONT_BAKE_SIZE, .glyphCount = FONT_BAKE_GLYPHS, .glyphPadding = FONT_BAKE_PADDING
+	};
+	font.glyphs = LoadFontData(data, size, font.baseSize, NULL, font.glyphCount, FONT_DEFAULT);
+	UnloadFileData(data);
+	if (font.glyphs == NULL) return false;
+
+	Image atlas = GenImageFontAtlas(font.glyphs, &font.recs, font.glyphCount, font.baseSize, font.glyphPadding, 0);
+	CutGlyphImages(&font, atlas);
+	bake->font = font;
+	bake->atlas = atlas;
+	return true;
+}
+
+void *FontLoaderMain(void *arg) {
+	FontBake *bake = arg;
+	wc_timeval before, after;
+	RecordTime(before);
+	bake->fromCache = LoadFontCache(bake);
+	if (!bake->fromCache && BakeFont(bake)) SaveFontCache(bake);
+	RecordTime(after);
+	bake->time = GetTimespan(before, after);
+	atomic_store(&bake->done, true);
+	return NULL;
+}
+
+void StartFontLoader() {
+	atomic_store(&PendingFont.done, false);
+	pthread_create(&FontLoader, NULL, FontLoaderMain, &PendingFont);
+}
+
+// gl has to be touched from the main thread, so the atlas upload happens here
+// once the loader is finished. with wait=false this is a no-op until then.
+void FinishFontLoader(bool wait) {
+	if (DebugFontLoaded) return;
+	if (!wait && !atomic_load(&PendingFont.done)) return;
+	pthread_join(FontLoader, NULL);
+
+	wc_timeval before, after;
+	RecordTime(before);
+	if (PendingFont.font.glyphs != NULL) {
+		debugFont = PendingFont.font;
+		debugFont.texture = LoadTextureFromImage(PendingFont.atlas);
+		SetTextureFilter(debugFont.texture, TEXTURE_FILTER_POINT);
+		UnloadImage(PendingFont.atlas);
+	} else {
+		debugFont = GetFontDefault(); // same fallback as LoadFont()
+	}
+	RecordTime(after);
+
+	Startup.fontBake = PendingFont.time;
+	Startup.fontCached = PendingFont.fromCache;
+	Startup.fontUpload = GetTimespan(before, after);
+	DebugFontLoaded = true;
+}
+
+// ---- world ----
+
+// everything a settled world depends on that isn't in the file itself
+typedef struct worldCacheKey {
+	long exeModTime;
+	b2Vec2 worldSize;
+	b2Vec2 gravity;
+	float timeStep;
+	int subStepCount;
+	int spawnSteps;
+	int prewarmSteps;
+	float chunkSize;
+	int layoutCount;
+	int ballCount;
+} WorldCacheKey;
+
+typedef struct worldCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	WorldCacheKey key;
+	int stepCount;
+	int boxCount;
+	int chunkCount;
+} WorldCacheHeader;
+
+// initial pose and size of a layout body, straight after AddLayoutGeometry()
+typedef struct layoutShape {
+	b2Vec2 pos;
+	float angle;
+	b2Vec2 hExtent;
+} LayoutShape;
+
+LayoutShape LayoutInitial[MAX_LAYOUT_BOXES + BALL_COUNT];
+int LayoutInitialCount = 0;
+
+typedef struct bodyState {
+	b2Vec2 pos;
+	float angle;
+	b2Vec2 linearVelocity;
+	float angularVelocity;
+	bool isAwake;
+} BodyState;
+
+typedef struct snapshotBox {
+	BoxRecord box;
+	b2Vec2 linearVelocity;
+	float angularVelocity;
+} SnapshotBox;
+
+typedef struct chunkCacheEntry {
+	int cx, cy;
+	bool isLive;
+	int packedCount;
+} ChunkCacheEntry;
+
+BodyState GetBodyState(b2BodyId id) {
+	b2Transform tr = b2Body_GetTransform(id);
+	return (BodyState) {
+		.pos = tr.p, .angle = b2Rot_GetAngle(tr.q),
+		.linearVelocity = b2Body_GetLinearVelocity(id),
+		.angularVelocity = b2Body_GetAngularVelocity(id),
+		.isAwake = b2Body_IsAwake(id),
+	};
+}
+
+void SetBodyState(b2BodyId id, BodyState s) {
+	b2Body_SetTransform(id, s.pos, b2MakeRot(s.angle));
+	b2Body_SetLinearVelocity(id, s.linearVelocity);
+	b2Body_SetAngularVelocity(id, s.angularVelocity);
+	if (!s.isAwake) b2Body_SetAwake(id, false);
+}
+
+WorldCacheKey MakeWorldCacheKey(b2Vec2 worldSize) {
+	WorldCacheKey key;
+	memset(&key, 0, sizeof(key)); // compared with memcmp, so no stray padding
+	key.exeModTime = ExeModTime;
+	key.worldSize = worldSize;
+	key.gravity = b2World_GetGravity(worldId);
+	key.timeStep = timeStep;
+	key.subStepCount = subStepCount;
+	key.spawnSteps = SPAWN_STEPS;
+	key.prewarmSteps = PREWARM_STEPS;
+	key.chunkSize = CHUNK_SIZE;
+	key.layoutCount = LayoutBoxCount;
+	key.ballCount = BALL_COUNT;
+	return key;
+}
+
+// call on a freshly built layout, before anything has stepped
+void RecordLayoutInitial() {
+	LayoutInitialCount = 0;
+	for (int i = 0; i < LayoutBoxCount; i++) {
+		b2Transform tr = b2Body_GetTransform(LayoutBoxes[i].id);
+		LayoutInitial[LayoutInitialCount++] = (LayoutShape) {
+			tr.p, b2Rot_GetAngle(tr.q), LayoutBoxes[i].hExtent
+		};
+	}
+	for (int i = 0; i < BALL_COUNT; i++) {
+		b2Transform tr = b2Body_GetTransform(Balls[i].id);
+		LayoutInitial[LayoutInitialCount++] = (LayoutShape) {
+			tr.p, b2Rot_GetAngle(tr.q), {Balls[i].radius, Balls[i].radius}
+		};
+	}
+}
+
+bool ChunkIsVisited(const Chunk *c) {
+	return c->state != CHUNK_FREE && c->visited;
+}
+
+void SaveWorldSnapshot(b2Vec2 worldSize) {
+	pthread_mutex_lock(&ChunkLock);
+	int chunkCount = 0;
+	for (int i = 0; i < MAX_CHUNKS; i++) chunkCount += ChunkIsVisited(&Chunks[i]);
+
+	WorldCacheHeader h = {
+		.magic = WORLD_CACHE_MAGIC, .version = STARTUP_CACHE_VERSION,
+		.key = MakeWorldCacheKey(worldSize), .stepCount = StepCount,
+		.boxCount = BoxCount, .chunkCount = chunkCount,
+	};
+
+	MakeDirectory(CACHE_DIR);
+	FILE *f = fopen(WORLD_CACHE_PATH, "wb");
+	if (f == NULL) {
+		pthread_mutex_unlock(&ChunkLock);
+		return;
+	}
+	fwrite(&h, sizeof(h), 1, f);
+	fwrite(LayoutInitial, sizeof(LayoutShape), LayoutInitialCount, f);
+
+	for (int i = 0; i < LayoutBoxCount; i++) {
+		BodyState s = GetBodyState(LayoutBoxes[i].id);
+		fwrite(&s, sizeof(s), 1, f);
+	}
+	for (int i = 0; i < BALL_COUNT; i++) {
+		BodyState s = GetBodyState(Balls[i].id);
+		fwrite(&s, sizeof(s), 1, f);
+	}
+
+	for (int i = 0; i < BoxCount; i++) {
+		b2BodyId id = Boxes[i].id;
+		b2ShapeId shapeId;
+		b2Body_GetShapes(id, &shapeId, 1);
+		BodyState s = GetBodyState(id);
+		SnapshotBox b = {
+			.box = {
+				.pos = s.pos, .angle = s.angle, .hExtent = Boxes[i].hExtent,
+				.density = b2Shape_GetDensity(shapeId), .friction = b2Shape_GetFriction(shapeId),
+				.isDynamic = b2Body_GetType(id) == b2_dynamicBody, .isAwake = s.isAwake,
+			},
+			.linearVelocity = s.linearVelocity, .angularVelocity = s.angularVelocity,
+		};
+		fwrite(&b, sizeof(b), 1, f);
+	}
+
+	// live chunks only need their coords (their bodies are in Boxes above),
+	// everything else that has been visited keeps its packed boxes
+	for (int i = 0; i < MAX_CHUNKS; i++) {
+		const Chunk *c = &Chunks[i];
+		if (!ChunkIsVisited(c)) continue;
+		bool isLive = c->state == CHUNK_LIVE;
+		ChunkCacheEntry e = {
+			.cx = c->cx, .cy = c->cy, .isLive = isLive, .packedCount = isLive ? 0 : c->packedCount
+		};
+		fwrite(&e, sizeof(e), 1, f);
+		fwrite(c->packed, sizeof(PackedBox), e.packedCount, f);
+	}
+	fclose(f);
+	pthread_mutex_unlock(&ChunkLock);
+}
+
+// expects a fresh world with AddLayoutGeometry(), RecordLayoutInitial() and
+// SetupChunks() already run. leaves the world untouched if the snapshot is
+// missing or was made from different inputs.
+bool LoadWorldSnapshot(b2Vec2 worldSize) {
+	if (!FileExists(WORLD_CACHE_PATH)) return false;
+	int size;
+	unsigned char *data = LoadFileData(WORLD_CACHE_PATH, &size);
+	if (data == NULL) return false;
+
+	CacheReader r = {data, size, 0};
+	WorldCacheHeader h;
+	WorldCacheKey key = MakeWorldCacheKey(worldSize);
+	LayoutShape initial[MAX_LAYOUT_BOXES + BALL_COUNT];
+	bool ok = CacheRead(&r, &h, sizeof(h)) &&
+	          h.magic == WORLD_CACHE_MAGIC && h.version == STARTUP_CACHE_VERSION &&
+	          memcmp(&h.key, &key, sizeof(key)) == 0 &&
+	          h.boxCount >= 0 && h.boxCount <= MAX_BOXES && h.chunkCount >= 0 &&
+	          CacheRead(&r, initial, LayoutInitialCount * sizeof(LayoutShape)) &&
+	          memcmp(initial, LayoutInitial, LayoutInitialCount * sizeof(LayoutShape)) == 0;
+
+	// walk the chunk entries once to check the file is whole before building anything
+	int bodiesAt = r.at;
+	if (ok) r.at += (h.key.layoutCount + h.key.ballCount) * (int)sizeof(BodyState) + h.boxCount * (int)sizeof(SnapshotBox);
+	for (int i = 0; ok && i < h.chunkCount; i++) {
+		ChunkCacheEntry e;
+		ok = CacheRead(&r, &e, sizeof(e)) && e.packedCount >= 0 && e.packedCount <= size;
+		if (ok) r.at += e.packedCount * (int)sizeof(PackedBox);
+	}
+	ok = ok && r.at == size;
+	if (!ok) {
+		UnloadFileData(data);
+		return false;
+	}
+	r.at = bodiesAt;
+
+	for (int i = 0; i < h.key.layoutCount; i++) {
+		BodyState s;
+		CacheRead(&r, &s, sizeof(s));
+		SetBodyState(LayoutBoxes[i].id, s);
+	}
+	for (int i = 0; i < h.key.ballCount; i++) {
+		BodyState s;
+		CacheRead(&r, &s, sizeof(s));
+		SetBodyState(Balls[i].id, s);
+	}
+
+	for (int i = 0; i < h.boxCount; i++) {
+		SnapshotBox b;
+		CacheRead(&r, &b, sizeof(b));
+		Boxes[BoxCount] = CreateBoxFromRecord(b.box);
+		if (b.box.isAwake) {
+			b2Body_SetLinearVelocity(Boxes[BoxCount].id, b.linearVelocity);
+			b2Body_SetAngularVelocity(Boxes[BoxCount].id, b.angularVelocity);
+		}
+		BoxCount++;
+	}
+
+	pthread_mutex_lock(&ChunkLock);
+	for (int i = 0; i < h.chunkCount; i++) {
+		ChunkCacheEntry e;
+		CacheRead(&r, &e, sizeof(e));
+		int idx = FindChunk(e.cx, e.cy, true);
+		if (idx < 0) {
+			r.at += e.packedCount * (int)sizeof(PackedBox);
+			continue;
+		}
+		Chunk *c = &Chunks[idx];
+		c->visited = true;
+		c->state = e.isLive ? CHUNK_LIVE : CHUNK_FROZEN;
+		if (e.packedCount > 0) {
+			c->packed = malloc(e.packedCount * sizeof(PackedBox));
+			CacheRead(&r, c->packed, e.packedCount * sizeof(PackedBox));
+		}
+		c->packedCount = e.packedCount;
+		c->packedCap = e.packedCount;
+	}
+	pthread_mutex_unlock(&ChunkLock);
+
+	StepCount = h.stepCount;
+	UnloadFileData(data);
+	return true;
+}
+
+void PrintStartupTimes() {
+	if (Startup.printed || !Startup.firstFrameDone || !DebugFontLoaded) return;
+	Startup.printed = true;
+	char label[64];
+	printf("startup:\n");
+	printf("  %-28s", "window");
+	PrintTimespan(Startup.window);
+	snprintf(label, sizeof(label), "world (%s)", Startup.worldSource);
+	printf("  %-28s", label);
+	PrintTimespan(Startup.world);
+	snprintf(label, sizeof(label), "font bake (%s, bg)", Startup.fontCached ? "cached" : "rasterized");
+	printf("  %-28s", label);
+	PrintTimespan(Startup.fontBake);
+	printf("  %-28s", "font upload");
+	PrintTimespan(Startup.fontUpload);
+	printf("  %-28s", "first frame (since launch)");
+	PrintTimespan(Startup.firstFrame);
+}
+
 // ----------------------
 // ------MAIN FILE-------
 // ----------------------
 
 bool QueueRestart = false;
+b2Vec2 SpawnPoint;
 
 //void HandleInput() {
 //	Vector2 mousePos = {GetMouseX(), GetMouseY()};
@@ -402,6 +1511,13 @@ void HandleInput() {
 	}
 	if(IsKeyPressed(KEY_R)) QueueRestart = true;
 
+	b2Vec2 pan = {0.0f, 0.0f};
+	if(IsKeyDown(KEY_LEFT)) pan.x -= 1.0f;
+	if(IsKeyDown(KEY_RIGHT)) pan.x += 1.0f;
+	if(IsKeyDown(KEY_DOWN)) pan.y -= 1.0f;
+	if(IsKeyDown(KEY_UP)) pan.y += 1.0f;
+	ViewVelocity = b2MulSV(CAMERA_PAN_SPEED, pan);
+	ViewOrigin = b2MulAdd(ViewOrigin, GetFrameTime(), ViewVelocity);
 }
 void HandleDrawing() {
 	ClearBackground(BLACK);
@@ -427,13 +1543,14 @@ void updateDebugMenu(Timespan inpTime, Timespan simTime, Timespan drawTime) {
 	if (StepCount % DebugUpdateRate == 0) {
 		FrameTimeMS = GetFrameTime() * 1000.0f;
 		FrameRate = 1000.0f / FrameTimeMS;
-		sprintf(debug_text, "inputtime: %0.2lfms\nsimtime:   %0.2lfms\ndrawtime:  %0.2lfms\nframetime: %0.2fms\nframerate: %0.1f\nboxcount:%d/%d\nsimpaused:%d", \
+		sprintf(debug_text, "inputtime: %0.2lfms\nsimtime:   %0.2lfms\ndrawtime:  %0.2lfms\nframetime: %0.2fms\nframerate: %0.1f\nboxcount:%d/%d\nchunks:    %d live, %d frozen\nsimpaused:%d", \
 		        inputMS, \
 		        simMS, \
 		        drawMS, \
 		        FrameTimeMS, \
 		        FrameRate, \
 		        BoxCount, MAX_BOXES,
+		        LiveChunkCount, FrozenChunkCount,
 		        SimulationPaused);
 	}
 }
@@ -547,6 +1664,9 @@ void AddLayoutGeometry(b2Vec2 worldSize) {
 		2.25f, 5.0f
 	}, 0.5f, IS_DYNAMIC);
 
+	// tag the layout so chunk freezing knows these stay put
+	for (int i = 0; i < LayoutBoxCount; i++) b2Body_SetUserData(LayoutBoxes[i].id, &PinnedBodyTag);
+	for (int i = 0; i < BALL_COUNT; i++) b2Body_SetUserData(Balls[i].id, &PinnedBodyTag);
 }
 
 void RestartSimulation() {
@@ -555,28 +1675,59 @@ void RestartSimulation() {
 	LayoutBoxCount = 0;
 	StepCount = 0;
 	FrameCount = 0;
+	ViewOrigin = b2Vec2_zero;
+	ResetChunks();
 	b2DestroyWorld(worldId);
 }
 
 void HandleUpdates() {
 	b2World_Step(worldId, timeStep, subStepCount);
-	if (StepCount < 350) {
-		SpawnBoxAtScreenPos((Vector2) {
-			0.02f, 32.5f
-		});
+	if (StepCount < SPAWN_STEPS) {
+		AttemptSpawnBox(SpawnPoint);
 	}
 	StepCount++;
 }
-int main() {
+
+// returns where the starting state came from, for the startup breakdown
+const char *PrewarmWorld(b2Vec2 worldSize) {
+#if PREWARM_WORLD
+	RecordLayoutInitial();
+	if (LoadWorldSnapshot(worldSize)) return "snapshot";
+
+	Prewarming = true;
+	while (StepCount < PREWARM_STEPS) {
+		HandleUpdates();
+		if (StepCount % CHUNK_UPDATE_RATE == 0) UpdateChunkStreaming();
+	}
+	Prewarming = false;
+	SaveWorldSnapshot(worldSize);
+	return "simulated";
+#else
+	return "fresh";
+#endif
+}
+int main(int argc, char **argv) {
+	wc_timeval before_phase, after_phase;
+	RecordTime(Startup.launch);
+	// keys the startup caches, any rebuild invalidates them
+	const char *exePath = argc > 0 ? argv[0] : "";
+	if (!FileExists(exePath)) exePath = TextFormat("%s%s", GetApplicationDirectory(), GetFileName(exePath));
+	if (FileExists(exePath)) ExeModTime = GetFileModTime(exePath);
+	// font is cpu work until the texture upload, so let it overlap everything else
+	StartFontLoader();
+
 //raysetup()
+	RecordTime(before_phase);
 	InitWindow(800, 400, "RayBox2D");
 	SetTargetFPS(120);
 	ToggleBorderlessWindowed();
+	RecordTime(after_phase);
+	Startup.window = GetTimespan(before_phase, after_phase);
 
 	windowSize = (Vector2) {
 		GetScreenWidth(), GetScreenHeight()
 	};
-	debugFont = LoadFont("fonts/0xProtoNerdFont-Regular.ttf");
+	StartChunkWorker();
 
 //b2setup()
 	do {
@@ -585,8 +1736,18 @@ int main() {
 			windowSize.x / PPM, windowSize.y / PPM
 		};
 		float gravity_y = -10.f;
+		RecordTime(before_phase);
 		worldId = InitWorld(gravity_y);
 		AddLayoutGeometry(worldSize);
+		SetupChunks(worldSize);
+		SpawnPoint = screenToWorld(0.02f, 32.5f); // fixed in the world, not on screen
+		const char *worldSource = PrewarmWorld(worldSize);
+		UpdateChunkStreaming();
+		RecordTime(after_phase);
+		if (!Startup.printed) {
+			Startup.world = GetTimespan(before_phase, after_phase);
+			Startup.worldSource = worldSource;
+		}
 
 		wc_timeval before_input, after_input, before_sim, after_sim, before_draw, after_draw;
 		while (!WindowShouldClose() && !QueueRestart) {
@@ -601,12 +1762,21 @@ int main() {
 				RecordTime(after_sim);
 			}
 
+			if (FrameCount % CHUNK_UPDATE_RATE == 0) UpdateChunkStreaming();
+
 			RecordTime(before_draw);
 			BeginDrawing();
 			HandleDrawing();
 			EndDrawing();
 			RecordTime(after_draw);
 
+			FinishFontLoader(false);
+			if (!Startup.firstFrameDone) {
+				Startup.firstFrame = GetTimespan(Startup.launch, after_draw);
+				Startup.firstFrameDone = true;
+			}
+			PrintStartupTimes();
+
 			Timespan inputTime = GetTimespan(before_input, after_input);
 			Timespan simTime = GetTimespan(before_sim, after_sim);
 			Timespan drawTime = GetTimespan(before_draw, after_draw);
@@ -616,11 +1786,16 @@ int main() {
 		if (QueueRestart) RestartSimulation();
 	} while(QueueRestart == true);
 
+	ResetChunks();
+	StopChunkWorker();
+	FinishFontLoader(true);
+	UnloadFont(debugFont);
 	b2DestroyWorld(worldId);
 	CloseWindow();
 }
 
 void DrawDebugMenu(float ox, float oy) {
+	if (!DebugFontLoaded) return; // still baking on the loader thread
 	const float fontsize = 24.0f;
 	const float spacing = 1.0f;
 	Vector2 pos = (Vector2) {